@@ -1,6 +1,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
 #include <dlfcn.h>  // Linux specific header for dynamic loading
 
 uint64_t buf[64] = {1,2,3,4,5};
@@ -12,25 +16,198 @@ void print_data(uint64_t * buf){
     int i;
     for (i = 0; i < 10; ++i)
     {
-        printf("%d, ", buf[i]);
+        printf("%" PRIu64 ", ", buf[i]);
     }
     printf("\n");
 }
 
-int main() {
+#define DRAM_ORDER_NONE ((uint64_t)-1)
+#define DRAM_ABI_VERSION 6
+#define BENCH_STEP_PS 1000
+
+// Throughput benchmark of the library interface, run with:
+//   a.out --bench [-n transactions] [-p seq|rand] [-w write %] [-s strobe density %]
+//         [-o outstanding] [-l transaction bytes] [-a burst|byte] [-c simulation json] [-t]
+// -a selects the entry points driving the transactions: dram_send_burst and dram_get_read_burst,
+// or the byte staging API dram_write_buffer, dram_write_strobe, dram_send_req and
+// dram_get_read_rsp. -t uses a timing-only DRAM. SystemC is advanced by steps of 1ns whenever
+// the DRAM can not accept a new transaction.
+int run_benchmark(void *libraryHandle, int argc, char **argv) {
+    int nb_txns = 100000;
+    int random_pattern = 0;
+    int write_ratio = 0;
+    int strobe_density = 100;
+    int outstanding = 32;
+    uint64_t length = 0;
+    int byte_api = 0;
+    int timing_only = 0;
+    char *config_path = "add_dramsyslib_patches/dramsys_configs/hbm2-example.json";
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:p:w:s:o:l:a:c:t")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n': nb_txns = atoi(optarg); break;
+            case 'p': random_pattern = strcmp(optarg, "rand") == 0; break;
+            case 'w': write_ratio = atoi(optarg); break;
+            case 's': strobe_density = atoi(optarg); break;
+            case 'o': outstanding = atoi(optarg); break;
+            case 'l': length = strtoull(optarg, NULL, 0); break;
+            case 'a': byte_api = strcmp(optarg, "byte") == 0; break;
+            case 'c': config_path = optarg; break;
+            case 't': timing_only = 1; break;
+            default:
+                printf("unknown benchmark option\n");
+                return 1;
+        }
+    }
+
+    void * (*add_dram)(char *, char *, int) = dlsym(libraryHandle, timing_only ? "add_dram_timing_only" : "add_dram");
+    void (*cloes_dram)(void *) = dlsym(libraryHandle, "cloes_dram");
+    uint64_t (*dram_get_burst_size)(void *) = dlsym(libraryHandle, "dram_get_burst_size");
+    uint64_t (*dram_get_size)(void *) = dlsym(libraryHandle, "dram_get_size");
+    int (*dram_can_accept_req)(void *) = dlsym(libraryHandle, "dram_can_accept_req");
+    int (*dram_has_read_rsp)(void *) = dlsym(libraryHandle, "dram_has_read_rsp");
+    int (*dram_has_write_rsp)(void *) = dlsym(libraryHandle, "dram_has_write_rsp");
+    int (*dram_get_write_rsp)(void *) = dlsym(libraryHandle, "dram_get_write_rsp");
+    int (*dram_get_pending_req)(void *) = dlsym(libraryHandle, "dram_get_pending_req");
+    int (*dram_write_buffer)(void *, int, int) = dlsym(libraryHandle, "dram_write_buffer");
+    int (*dram_write_strobe)(void *, int, int) = dlsym(libraryHandle, "dram_write_strobe");
+    void (*dram_send_req)(void *, uint64_t, uint64_t, uint64_t, uint64_t) = dlsym(libraryHandle, "dram_send_req");
+    uint64_t (*dram_send_burst)(void *, uint64_t, uint64_t, const uint8_t *, const uint8_t *, uint64_t, uint64_t) = dlsym(libraryHandle, "dram_send_burst");
+    void (*dram_get_read_rsp)(void *, uint64_t, const void *) = dlsym(libraryHandle, "dram_get_read_rsp");
+    void (*dram_get_read_burst)(void *, uint64_t, uint64_t, uint8_t *) = dlsym(libraryHandle, "dram_get_read_burst");
+    void (*dram_run_until)(uint64_t) = dlsym(libraryHandle, "dram_run_until");
+
+    void * dram = add_dram("add_dramsyslib_patches/dramsys_configs", config_path, outstanding);
+    uint64_t burst = dram_get_burst_size(dram);
+    uint64_t range = dram_get_size(dram);
+    if (length == 0) length = burst;
+    // The byte staging buffers of the library are 2KB
+    if (byte_api && length > 2048) length = 2048;
+
+    uint8_t *data = malloc(length);
+    uint8_t *strb = malloc(length);
+    uint8_t *rsp = malloc(length);
+    int strobe = strobe_density < 100;
+    for (uint64_t i = 0; i < length; i++)
+    {
+        data[i] = i;
+        // Spread the enabled bytes over the transaction
+        strb[i] = (int)((i * 37) % 100) < strobe_density ? 0xff : 0x00;
+    }
+
+    struct timespec host_start, host_end;
+    uint64_t now_ps = 0;
+    uint64_t seed = 1;
+    uint64_t bytes = 0;
+    clock_gettime(CLOCK_MONOTONIC, &host_start);
+
+    for (int i = 0; i <= nb_txns; i++)
+    {
+        // Wait for room, or for all responses after the last transaction
+        while (i == nb_txns ? dram_get_pending_req(dram) != 0 : !dram_can_accept_req(dram))
+        {
+            now_ps += BENCH_STEP_PS;
+            dram_run_until(now_ps);
+            while (dram_has_read_rsp(dram))
+            {
+                // Timing-only responses have no data, only the byte API fills the buffer with zeros
+                if (byte_api)
+                    dram_get_read_rsp(dram, length, rsp);
+                else
+                    dram_get_read_burst(dram, 0, timing_only ? 0 : length, rsp);
+            }
+            while (dram_has_write_rsp(dram)) dram_get_write_rsp(dram);
+        }
+        if (i == nb_txns) break;
+
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        uint64_t addr = random_pattern ? ((seed >> 20) % (range / length)) * length : (i * length) % range;
+        int is_write = (int)((seed >> 8) % 100) < write_ratio;
+
+        if (byte_api)
+        {
+            if (is_write)
+            {
+                for (uint64_t j = 0; j < length; j++)
+                {
+                    dram_write_buffer(dram, data[j], j);
+                    dram_write_strobe(dram, strb[j], j);
+                }
+            }
+            dram_send_req(dram, addr, length, is_write, is_write && strobe);
+        }
+        else
+        {
+            // Strobed writes longer than a burst are sent one burst per slot, the rest is sent
+            // once there is room again
+            uint64_t sent = 0;
+            while (1)
+            {
+                sent += dram_send_burst(dram, addr + sent, length - sent, is_write ? data + sent : NULL,
+                    is_write && strobe ? strb + sent : NULL, 0, DRAM_ORDER_NONE);
+                if (sent == length) break;
+                while (!dram_can_accept_req(dram))
+                {
+                    now_ps += BENCH_STEP_PS;
+                    dram_run_until(now_ps);
+                }
+            }
+        }
+        bytes += length;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &host_end);
+    double host_ns = (host_end.tv_sec - host_start.tv_sec) * 1e9 + (host_end.tv_nsec - host_start.tv_nsec);
+
+    printf("bench %s %s w%d%% s%d%% o%d l%" PRIu64 "%s: %d txns, host %.0f txn/s, sim %.2f GB/s, %.1f host-ns/txn\n",
+        byte_api ? "byte" : "burst", random_pattern ? "rand" : "seq", write_ratio, strobe_density, outstanding, length,
+        timing_only ? " timing-only" : "", nb_txns, nb_txns * 1e9 / host_ns,
+        now_ps ? (double)bytes * 1000 / now_ps : 0.0, host_ns / nb_txns);
+
+    free(data);
+    free(strb);
+    free(rsp);
+    cloes_dram(dram);
+    dlclose(libraryHandle);
+    return 0;
+}
+
+int main(int argc, char **argv) {
     void* libraryHandle;
-    int (*add_dram)(char *, char *);
-    void (*cloes_dram)(int);
-    int (*dram_can_accept_req)(int);
-    void (*dram_write_buffer)(int dram_id, int byte_int, int idx);
-    void (*dram_write_strobe)(int dram_id, int strob_int, int idx);
-    int (*dram_has_read_rsp)(int dram_id);
-    void (*dram_send_req)(int dram_id, uint64_t addr, uint64_t length , uint64_t is_write, uint64_t strob_enable);
-    void (*dram_get_read_rsp)(int dram_id, uint64_t length, const void * buf);
+    void * (*add_dram)(char *, char *, int);
+    void (*cloes_dram)(void *);
+    int (*dram_can_accept_req)(void *);
+    int (*dram_write_buffer)(void * dram_id, int byte_int, int idx);
+    int (*dram_write_strobe)(void * dram_id, int strob_int, int idx);
+    int (*dram_has_read_rsp)(void * dram_id);
+    void (*dram_send_req)(void * dram_id, uint64_t addr, uint64_t length , uint64_t is_write, uint64_t strob_enable);
+    void (*dram_get_read_rsp)(void * dram_id, uint64_t length, const void * buf);
     void (*run_ns)(int ns);
+    uint64_t (*dram_get_payload_alloc_count)(void * dram_id);
 
     printf("load library --- \n");
     libraryHandle = dlopen("third_party/DRAMSys/libDRAMSys_Simulator.so", RTLD_LAZY);
+    if (libraryHandle == NULL)
+    {
+        printf("Failed to load DRAMSys library: %s\n", dlerror());
+        return 1;
+    }
+
+    // A stale library exports the same names with other signatures
+    int (*dram_get_abi_version)() = dlsym(libraryHandle, "dram_get_abi_version");
+    if (dram_get_abi_version == NULL || dram_get_abi_version() != DRAM_ABI_VERSION)
+    {
+        printf("DRAMSys library has an incompatible interface, expected version %d\n", DRAM_ABI_VERSION);
+        return 1;
+    }
+
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0)
+    {
+        return run_benchmark(libraryHandle, argc - 1, argv + 1);
+    }
 
     printf("get function --- \n");
     add_dram = dlsym(libraryHandle, "add_dram");
@@ -42,16 +219,17 @@ int main() {
     dram_write_buffer = dlsym(libraryHandle, "dram_write_buffer");
     dram_write_strobe = dlsym(libraryHandle, "dram_write_strobe");
     run_ns = dlsym(libraryHandle, "run_ns");
+    dram_get_payload_alloc_count = dlsym(libraryHandle, "dram_get_payload_alloc_count");
 
     
 
     printf("use function --- \n");
 
     // Use the function from the dynamic library
-    int dram_id = add_dram("add_dramsyslib_patches/dramsys_configs", "add_dramsyslib_patches/dramsys_configs/hbm2-example.json");
-    int dram_id2 = add_dram("add_dramsyslib_patches/dramsys_configs", "add_dramsyslib_patches/dramsys_configs/hbm2-example.json");
+    void * dram_id = add_dram("add_dramsyslib_patches/dramsys_configs", "add_dramsyslib_patches/dramsys_configs/hbm2-example.json", 1);
+    void * dram_id2 = add_dram("add_dramsyslib_patches/dramsys_configs", "add_dramsyslib_patches/dramsys_configs/hbm2-example.json", 1);
     run_ns(1000);
-    printf("get dram id: %d\n", dram_id);
+    printf("get dram id: %p\n", dram_id);
 
     print_data(buf);
     print_data(rec);
@@ -89,19 +267,70 @@ int main() {
 
     printf("check read resp  \n");
 
+    int status = 0;
     if (dram_has_read_rsp(dram_id))
     {
         printf("get read response \n");
         dram_get_read_rsp(dram_id, TXN_LEN, (void *)rec);
     }
+    else
+    {
+        printf("no read response\n");
+        status = 1;
+    }
 
     print_data(rec);
 
+    //the first 10 bytes were not enabled by the strobe and keep the initial zeros
+    uint8_t * byte_buf = (uint8_t *)buf;
+    uint8_t * byte_rec = (uint8_t *)rec;
+    for (int i = 0; i < TXN_LEN; ++i)
+    {
+        uint8_t expected = i < 10 ? 0 : byte_buf[i];
+        if (byte_rec[i] != expected)
+        {
+            printf("read back byte %d: got %d, expected %d\n", i, byte_rec[i], expected);
+            status = 1;
+        }
+    }
+
+    //the same read again must be served from the payload pool, without new allocation
+    uint64_t alloc_count = dram_get_payload_alloc_count(dram_id);
+    if (dram_can_accept_req(dram_id))
+    {
+        dram_send_req(dram_id, 0, TXN_LEN, 0, 0);
+    }
+    run_ns(1000);
+    if (dram_has_read_rsp(dram_id))
+    {
+        dram_get_read_rsp(dram_id, TXN_LEN, (void *)rec);
+    }
+    else
+    {
+        printf("no response to the second read\n");
+        status = 1;
+    }
+    printf("payload allocations: %" PRIu64 ", after one more read: %" PRIu64 "\n", alloc_count, dram_get_payload_alloc_count(dram_id));
+    if (dram_get_payload_alloc_count(dram_id) != alloc_count)
+    {
+        printf("the second read allocated a payload\n");
+        status = 1;
+    }
+
+    //the staging buffers are 2KB, indexes outside of them must be rejected
+    if (dram_write_buffer(dram_id, 0, 2048) == 0 || dram_write_strobe(dram_id, 0, -1) == 0)
+    {
+        printf("staging buffer index out of range accepted\n");
+        status = 1;
+    }
+
+    // SystemC is only stopped once the last instance is closed
+    cloes_dram(dram_id2);
     cloes_dram(dram_id);
-    printf("close dram: %d\n", dram_id);
+    printf("close dram: %p\n", dram_id);
 
     // Unload the dynamic library
     dlclose(libraryHandle);
 
-    return 0;
+    return status;
 }
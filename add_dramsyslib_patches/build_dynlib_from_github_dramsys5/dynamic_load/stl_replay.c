@@ -0,0 +1,153 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+#include <time.h>
+#include <dlfcn.h>  // Linux specific header for dynamic loading
+
+// Replays an STL trace dumped by the GVSoC ddr model (stl-trace property) on a DRAMSys
+// instance, without the rest of the system, e.g. to sweep memory configurations.
+//
+// usage: stl_replay [-f] <trace.stl> [simulation json] [max outstanding]
+//
+// Accesses are sent at their trace timestamp, or later if DRAMSys can not accept them yet.
+// With -f, timestamps are ignored and accesses are sent as soon as DRAMSys accepts them, which
+// gives the sustainable bandwidth of the access pattern.
+
+#define RESOURCES_PATH "add_dramsyslib_patches/dramsys_configs"
+#define DEFAULT_CONFIG RESOURCES_PATH "/hbm2-example.json"
+#define DRAM_ORDER_NONE ((uint64_t)-1)
+#define DRAM_ABI_VERSION 6
+
+void * (*add_dram_timing_only)(char *, char *, int);
+void (*cloes_dram)(void *);
+uint64_t (*dram_get_burst_size)(void * dram_id);
+int (*dram_can_accept_req)(void *);
+int (*dram_has_read_rsp)(void * dram_id);
+int (*dram_has_write_rsp)(void * dram_id);
+int (*dram_get_write_rsp)(void * dram_id);
+uint64_t (*dram_send_burst)(void * dram_id, uint64_t addr, uint64_t length, const uint8_t * data, const uint8_t * strb, uint64_t tag, uint64_t order_id);
+void (*dram_get_read_burst)(void * dram_id, uint64_t offset, uint64_t size, uint8_t * buf);
+int (*dram_get_pending_req)(void * dram_id);
+void (*dram_run_until)(uint64_t time_ps);
+
+uint64_t now_ps = 0;
+// Read responses are only needed for their timing, their data is dropped here
+uint8_t rsp_data;
+
+void drain_rsp(void * dram_id){
+    while (dram_has_read_rsp(dram_id)) dram_get_read_burst(dram_id, 0, 0, &rsp_data);
+    while (dram_has_write_rsp(dram_id)) dram_get_write_rsp(dram_id);
+}
+
+void run_until(void * dram_id, uint64_t time_ps){
+    dram_run_until(time_ps);
+    now_ps = time_ps;
+    drain_rsp(dram_id);
+}
+
+int main(int argc, char **argv) {
+    void* libraryHandle;
+    int fast = 0;
+
+    if (argc > 1 && strcmp(argv[1], "-f") == 0)
+    {
+        fast = 1;
+        argc--;
+        argv++;
+    }
+    if (argc < 2)
+    {
+        printf("usage: stl_replay [-f] <trace.stl> [simulation json] [max outstanding]\n");
+        return 1;
+    }
+    char *trace_path = argv[1];
+    char *config_path = argc > 2 ? argv[2] : DEFAULT_CONFIG;
+    int max_outstanding = argc > 3 ? atoi(argv[3]) : 32;
+
+    FILE *trace = fopen(trace_path, "r");
+    if (trace == NULL)
+    {
+        printf("Failed to open trace %s\n", trace_path);
+        return 1;
+    }
+
+    libraryHandle = dlopen("third_party/DRAMSys/libDRAMSys_Simulator.so", RTLD_LAZY);
+    if (libraryHandle == NULL)
+    {
+        printf("Failed to load DRAMSys library: %s\n", dlerror());
+        return 1;
+    }
+
+    int (*dram_get_abi_version)() = dlsym(libraryHandle, "dram_get_abi_version");
+    if (dram_get_abi_version == NULL || dram_get_abi_version() != DRAM_ABI_VERSION)
+    {
+        printf("DRAMSys library has an incompatible interface, expected version %d\n", DRAM_ABI_VERSION);
+        return 1;
+    }
+
+    add_dram_timing_only = dlsym(libraryHandle, "add_dram_timing_only");
+    cloes_dram = dlsym(libraryHandle, "cloes_dram");
+    dram_get_burst_size = dlsym(libraryHandle, "dram_get_burst_size");
+    dram_can_accept_req = dlsym(libraryHandle, "dram_can_accept_req");
+    dram_has_read_rsp = dlsym(libraryHandle, "dram_has_read_rsp");
+    dram_has_write_rsp = dlsym(libraryHandle, "dram_has_write_rsp");
+    dram_get_write_rsp = dlsym(libraryHandle, "dram_get_write_rsp");
+    dram_send_burst = dlsym(libraryHandle, "dram_send_burst");
+    dram_get_read_burst = dlsym(libraryHandle, "dram_get_read_burst");
+    dram_get_pending_req = dlsym(libraryHandle, "dram_get_pending_req");
+    dram_run_until = dlsym(libraryHandle, "dram_run_until");
+
+    // The trace has no data, DRAMSys only needs to model the timing
+    void * dram_id = add_dram_timing_only(RESOURCES_PATH, config_path, max_outstanding);
+    uint64_t burst_size = dram_get_burst_size(dram_id);
+    uint8_t *write_data = calloc(1, burst_size);
+
+    struct timespec host_start, host_end;
+    clock_gettime(CLOCK_MONOTONIC, &host_start);
+
+    char line[256];
+    char command[16];
+    uint64_t period_ps = 1000;
+    uint64_t cycle, addr;
+    uint64_t nb_reads = 0, nb_writes = 0;
+
+    while (fgets(line, sizeof(line), trace))
+    {
+        if (line[0] == '#')
+        {
+            sscanf(line, "# clock period: %" SCNu64 " ps", &period_ps);
+            continue;
+        }
+        if (sscanf(line, "%" SCNu64 ": %15s %" SCNx64, &cycle, command, &addr) != 3) continue;
+
+        int is_write = strcmp(command, "write") == 0;
+
+        if (!fast && cycle * period_ps > now_ps) run_until(dram_id, cycle * period_ps);
+
+        // Move by one trace cycle until DRAMSys has room for the access
+        while (!dram_can_accept_req(dram_id)) run_until(dram_id, now_ps + period_ps);
+
+        dram_send_burst(dram_id, addr, burst_size, is_write ? write_data : NULL, NULL, 0, DRAM_ORDER_NONE);
+        if (is_write) nb_writes++; else nb_reads++;
+    }
+
+    while (dram_get_pending_req(dram_id)) run_until(dram_id, now_ps + period_ps);
+
+    clock_gettime(CLOCK_MONOTONIC, &host_end);
+    double host_time = (host_end.tv_sec - host_start.tv_sec) + (host_end.tv_nsec - host_start.tv_nsec) / 1e9;
+    uint64_t bytes = (nb_reads + nb_writes) * burst_size;
+
+    printf("replayed %" PRIu64 " reads and %" PRIu64 " writes in %.3f us of DRAM time (%.2f GB/s), %.3f s of host time\n",
+        nb_reads, nb_writes, now_ps / 1e6, now_ps ? (double)bytes * 1000 / now_ps : 0.0, host_time);
+
+    fclose(trace);
+    free(write_data);
+    cloes_dram(dram_id);
+
+    // Unload the dynamic library
+    dlclose(libraryHandle);
+
+    return 0;
+}
@@ -0,0 +1,256 @@
+#include <vp/vp.hpp>
+#include <vp/itf/io.hpp>
+#include <stdio.h>
+#include <string.h>
+#include <sstream>
+#include <vector>
+#include <map>
+
+// Runs a script of DRAM accesses and checks the data read back against the data written, so
+// that the DRAM bridges can be tested on their corner cases. The script is a list of commands
+// separated by ';':
+//   w <addr> <size>   write size bytes at addr, without waiting for the previous accesses
+//   r <addr> <size>   read size bytes at addr and check the bytes written before
+//   b                 wait until all the previous accesses are responded
+//   d <cycles>        wait for this number of cycles before going on
+// Each write has its own data pattern, so that a stale read is detected.
+class AccessGen : public vp::Component
+{
+public:
+    AccessGen(vp::ComponentConf &config);
+
+private:
+    typedef struct
+    {
+        char type;
+        uint64_t addr;
+        uint64_t size;
+    } cmd_t;
+
+    typedef struct
+    {
+        vp::IoReq req;
+        uint64_t addr;
+        std::vector<uint8_t> data;
+        // Expected value of each byte read, -1 for the bytes which were never written
+        std::vector<int> expected;
+    } access_t;
+
+    static void fsm_handler(vp::Block *__this, vp::ClockEvent *event);
+    static void timeout_handler(vp::Block *__this, vp::ClockEvent *event);
+    static void grant(vp::Block *__this, vp::IoReq *req);
+    static void response(vp::Block *__this, vp::IoReq *req);
+
+    void reset(bool active) override;
+    void issue(cmd_t *cmd);
+    void access_done(access_t *access);
+    void check_end();
+
+    vp::IoMaster output;
+    vp::ClockEvent fsm_event;
+    vp::ClockEvent timeout_event;
+
+    std::vector<cmd_t> cmds;
+    int64_t timeout;
+    unsigned int pc;
+    int nb_pending;
+    int nb_accesses;
+    int nb_errors;
+    int nb_writes;
+    bool denied;
+    bool finished;
+    // Last value written to each byte
+    std::map<uint64_t, uint8_t> memory;
+    std::map<vp::IoReq *, access_t *> pending_accesses;
+
+    static int nb_active;
+};
+
+int AccessGen::nb_active = 0;
+
+AccessGen::AccessGen(vp::ComponentConf &config)
+    : vp::Component(config), fsm_event(this, &AccessGen::fsm_handler),
+    timeout_event(this, &AccessGen::timeout_handler)
+{
+    this->output.set_grant_meth(&AccessGen::grant);
+    this->output.set_resp_meth(&AccessGen::response);
+    this->new_master_port("output", &this->output);
+
+    this->timeout = this->get_js_config()->get_child_int("timeout");
+
+    std::stringstream script(this->get_js_config()->get_child_str("script"));
+    std::string line;
+    while (std::getline(script, line, ';'))
+    {
+        std::stringstream fields(line);
+        cmd_t cmd = {0, 0, 0};
+        fields >> cmd.type >> cmd.addr >> cmd.size;
+        this->cmds.push_back(cmd);
+    }
+
+    nb_active++;
+}
+
+void AccessGen::reset(bool active)
+{
+    if (!active)
+    {
+        this->pc = 0;
+        this->nb_pending = 0;
+        this->nb_accesses = 0;
+        this->nb_errors = 0;
+        this->nb_writes = 0;
+        this->denied = false;
+        this->finished = false;
+        this->memory.clear();
+        this->fsm_event.enqueue();
+        this->timeout_event.enqueue(this->timeout);
+    }
+}
+
+void AccessGen::issue(cmd_t *cmd)
+{
+    access_t *access = new access_t;
+    bool is_write = cmd->type == 'w';
+
+    access->addr = cmd->addr;
+    access->data.resize(cmd->size);
+    if (is_write)
+    {
+        this->nb_writes++;
+        for (uint64_t i = 0; i < cmd->size; i++)
+        {
+            access->data[i] = (cmd->addr + i) * 7 + this->nb_writes * 13 + 1;
+            this->memory[cmd->addr + i] = access->data[i];
+        }
+    }
+    else
+    {
+        access->expected.resize(cmd->size);
+        for (uint64_t i = 0; i < cmd->size; i++)
+        {
+            auto it = this->memory.find(cmd->addr + i);
+            access->expected[i] = it == this->memory.end() ? -1 : it->second;
+        }
+    }
+
+    vp::IoReq *req = &access->req;
+    req->init();
+    req->set_addr(cmd->addr);
+    req->set_size(cmd->size);
+    req->set_is_write(is_write);
+    req->set_data(access->data.data());
+    this->nb_accesses++;
+
+    vp::IoReqStatus status = this->output.req(req);
+    if (status == vp::IO_REQ_OK)
+    {
+        this->access_done(access);
+    }
+    else if (status == vp::IO_REQ_INVALID)
+    {
+        printf("%s: invalid access (addr: 0x%lx, size: 0x%lx)\n", this->get_path().c_str(), cmd->addr, cmd->size);
+        this->nb_errors++;
+        delete access;
+    }
+    else
+    {
+        this->nb_pending++;
+        this->pending_accesses[req] = access;
+        this->denied = status == vp::IO_REQ_DENIED;
+    }
+}
+
+void AccessGen::access_done(access_t *access)
+{
+    for (uint64_t i = 0; i < access->expected.size(); i++)
+    {
+        if (access->expected[i] != -1 && access->expected[i] != access->data[i])
+        {
+            if (this->nb_errors < 10)
+            {
+                printf("%s: mismatch at 0x%lx (expected: 0x%x, got: 0x%x)\n", this->get_path().c_str(),
+                    access->addr + i, access->expected[i], access->data[i]);
+            }
+            this->nb_errors++;
+        }
+    }
+    delete access;
+}
+
+void AccessGen::fsm_handler(vp::Block *__this, vp::ClockEvent *event)
+{
+    AccessGen *_this = (AccessGen *)__this;
+
+    while (!_this->denied && _this->pc < _this->cmds.size())
+    {
+        cmd_t *cmd = &_this->cmds[_this->pc];
+        if (cmd->type == 'b')
+        {
+            if (_this->nb_pending) return;
+            _this->pc++;
+        }
+        else if (cmd->type == 'd')
+        {
+            _this->pc++;
+            _this->fsm_event.enqueue(cmd->addr);
+            return;
+        }
+        else
+        {
+            _this->pc++;
+            _this->issue(cmd);
+        }
+    }
+
+    _this->check_end();
+}
+
+void AccessGen::grant(vp::Block *__this, vp::IoReq *req)
+{
+    AccessGen *_this = (AccessGen *)__this;
+    _this->denied = false;
+    if (!_this->fsm_event.is_enqueued()) _this->fsm_event.enqueue();
+}
+
+void AccessGen::response(vp::Block *__this, vp::IoReq *req)
+{
+    AccessGen *_this = (AccessGen *)__this;
+
+    auto it = _this->pending_accesses.find(req);
+    _this->access_done(it->second);
+    _this->pending_accesses.erase(it);
+    _this->nb_pending--;
+
+    if (!_this->fsm_event.is_enqueued()) _this->fsm_event.enqueue();
+}
+
+void AccessGen::check_end()
+{
+    if (this->finished || this->pc != this->cmds.size() || this->nb_pending) return;
+    this->finished = true;
+
+    printf("access %s: %d accesses, %d errors\n", this->get_path().c_str(), this->nb_accesses, this->nb_errors);
+
+    if (--nb_active == 0)
+    {
+        this->time.get_engine()->quit(0);
+    }
+}
+
+void AccessGen::timeout_handler(vp::Block *__this, vp::ClockEvent *event)
+{
+    AccessGen *_this = (AccessGen *)__this;
+
+    if (!_this->finished)
+    {
+        printf("access %s: timeout with %d accesses pending at command %d\n", _this->get_path().c_str(),
+            _this->nb_pending, _this->pc);
+        _this->time.get_engine()->quit(1);
+    }
+}
+
+extern "C" vp::Component *gv_new(vp::ComponentConf &config)
+{
+    return new AccessGen(config);
+}
@@ -0,0 +1,33 @@
+import gvsoc.systree
+
+class AccessGen(gvsoc.systree.Component):
+    """Runs a script of DRAM accesses and checks the data read back, see access_gen.cpp"""
+
+    def __init__(self, parent: gvsoc.systree.Component, name: str, script: list, timeout: int=1000000):
+
+        super().__init__(parent, name)
+
+        self.add_sources(['access_gen.cpp'])
+
+        self.add_properties({
+            'script': ';'.join(script),
+            'timeout': timeout,
+        })
+
+    def o_OUTPUT(self, itf: gvsoc.systree.SlaveItf):
+        self.itf_bind('output', itf, signature='io')
+
+
+# Helpers building the script commands
+
+def write(addr: int, size: int):
+    return f'w {addr} {size}'
+
+def read(addr: int, size: int):
+    return f'r {addr} {size}'
+
+def barrier():
+    return 'b'
+
+def delay(cycles: int):
+    return f'd {cycles}'
@@ -0,0 +1,171 @@
+import vp.clock_domain
+import memory.dramsys
+import memory.dramsys_multichannel
+import gvsoc.systree
+import gvsoc.runner
+from access_gen import AccessGen, write, read, barrier, delay
+
+
+GAPY_TARGET = True
+
+
+def back_to_back(nb: int, size: int):
+    # More requests than the DRAM can have in flight, all issued without waiting, then read back,
+    # then reads and writes to other addresses mixed together
+    script = [write(i * size, size) for i in range(nb)] + [barrier()]
+    script += [read(i * size, size) for i in range(nb)] + [barrier()]
+    for i in range(nb):
+        script += [write(0x10000 + i * size, size), read(i * size, size)]
+    script += [barrier()]
+    script += [read(0x10000 + i * size, size) for i in range(nb)]
+    return script
+
+
+def multi_burst(nb: int):
+    # Unaligned accesses covering several bursts, more bursts than the DRAM can have in flight,
+    # then read back with other boundaries
+    script = [write(0x30 + i * 0x130, 0x130) for i in range(nb)] + [barrier()]
+    script += [read(0x10 + i * 0x100, 0x100) for i in range(nb)] + [barrier()]
+    script += [read(0x30 + i * 0x130, 0x130) for i in range(nb)]
+    return script
+
+
+# The scenarios below use the default hbm2 DRAM, whose bursts are 32 bytes. The number of DRAM
+# transactions they must produce is checked from the statistics in testset.cfg.
+
+def coalesce_merge():
+    # Partial writes merged into a complete burst, then partial writes flushed by the reads
+    # overlapping them, including a write overlapping bytes of a burst which was already flushed
+    script = [write(0x0, 8), write(0x8, 8), write(0x10, 8), write(0x18, 8)]
+    script += [write(0x48, 8), write(0x40, 8), read(0x40, 16), read(0x0, 32)]
+    script += [write(0x44, 4), read(0x40, 8)]
+    return script
+
+
+def coalesce_window():
+    # The first write is flushed by the window before the second one comes
+    return [write(0x0, 8), delay(100), write(0x8, 8), delay(100), read(0x0, 16)]
+
+
+def coalesce_evict():
+    # With 2 entries, every new burst evicts the oldest one
+    script = [write(0x0, 8), write(0x20, 8), write(0x40, 8), write(0x60, 8), write(0x8, 8)]
+    script += [read(0x0, 0x80)]
+    return script
+
+
+def coalesce_hazard():
+    # A read merged into a pending read, then writes to the burst of pending reads, complete and
+    # partial, after which the reads must go to DRAMSys again
+    script = [read(0x0, 32), read(0x0, 32), write(0x0, 32), read(0x0, 32)]
+    script += [read(0x40, 32), write(0x40, 8), read(0x48, 8)]
+    return script
+
+
+def raw_hazard(nb: int):
+    # Each burst written and read back right away, several times with new data, with complete
+    # bursts going straight to DRAMSys and partial ones through write combining. Nothing waits, so
+    # that DRAMSys could schedule the reads before the writes if the model did not hold them.
+    script = []
+    for rep in range(4):
+        for i in range(nb):
+            script += [write(i * 32, 32), read(i * 32, 32), read(i * 32, 32)]
+            script += [write(0x1000 + i * 32 + 8, 8), read(0x1000 + i * 32, 32)]
+    return script
+
+
+def interleaved(granularity: int, nb_channels: int):
+    # Accesses crossing granules at unaligned offsets, then accesses hitting the same channel with
+    # bit interleaving back-to-back so that its queue fills up, all read back with other boundaries
+    stride = granularity * nb_channels
+    script = [write(0x40 + i * granularity * 3, granularity * 3) for i in range(8)] + [barrier()]
+    script += [read(i * granularity, granularity) for i in range(24)] + [barrier()]
+    script += [write(0x100000 + i * stride + 0x20, 0x40) for i in range(32)] + [barrier()]
+    script += [read(0x100000 + i * stride, granularity) for i in range(32)] + [barrier()]
+    script += [read(0x100000 + i * stride + 0x20, 0x40) for i in range(32)]
+    return script
+
+
+class Testbench(gvsoc.systree.Component):
+
+    def __init__(self, parent, name):
+        super().__init__(parent, name)
+
+        # Each scenario has its own generator and DRAM, they all run in parallel
+        self.add_ddr_scenario('outstanding_1', back_to_back(32, 64), max_outstanding=1)
+        self.add_ddr_scenario('outstanding_4', back_to_back(32, 64), max_outstanding=4)
+        self.add_ddr_scenario('outstanding_lazy', back_to_back(32, 64), max_outstanding=1, lazy=True)
+
+        # Accesses sent one burst at a time
+        self.add_ddr_scenario('multi_burst_1', multi_burst(16), max_outstanding=1)
+        ddr = self.add_ddr_scenario('multi_burst_coalesce', multi_burst(16), max_outstanding=2)
+        ddr.set_coalescing(read_coalesce=True)
+        ddr = self.add_ddr_scenario('multi_burst_timing', multi_burst(16), max_outstanding=1)
+        ddr.set_timing_only()
+
+        # Coalescing, with a single transaction in flight so that the data read back does not
+        # depend on the DRAMSys scheduling
+        ddr = self.add_ddr_scenario('coalesce_merge', coalesce_merge(), max_outstanding=1)
+        ddr.set_coalescing(write_window=100000, read_coalesce=False)
+        ddr.set_stats()
+        ddr = self.add_ddr_scenario('coalesce_window', coalesce_window(), max_outstanding=1)
+        ddr.set_coalescing(write_window=16, read_coalesce=False)
+        ddr.set_stats()
+        ddr = self.add_ddr_scenario('coalesce_evict', coalesce_evict(), max_outstanding=1)
+        ddr.set_coalescing(write_window=100000, write_entries=2, read_coalesce=False)
+        ddr.set_stats()
+
+        # The reads must be in flight when the next accesses arrive, the data is kept in the host
+        # buffer so that only the number of transactions is checked
+        ddr = self.add_ddr_scenario('coalesce_hazard', coalesce_hazard())
+        ddr.set_coalescing(write_window=100000, read_coalesce=True)
+        ddr.set_timing_only()
+        ddr.set_stats()
+
+        # Reads behind writes to the same burst, at the default depth and with coalescing
+        ddr = self.add_ddr_scenario('raw_hazard', raw_hazard(16))
+        ddr.set_coalescing(write_window=16, read_coalesce=True)
+
+        # Channel queues and DRAMSys depths of 1 so that they are always full
+        for interleave in ['bit', 'xor']:
+            mem = memory.dramsys_multichannel.DramsysMultichannel(self, f'mem_multichannel_{interleave}',
+                nb_channels=4, interleave=interleave, interleave_granularity=256)
+            mem.add_properties({
+                'queue-depth': 1,
+                'max-outstanding': 1,
+            })
+            self.add_scenario(f'multichannel_{interleave}', interleaved(256, 4), mem)
+
+    def add_scenario(self, name, script, mem):
+        gen = AccessGen(self, f'gen_{name}', script=script)
+        gen.o_OUTPUT(gvsoc.systree.SlaveItf(mem, 'input', signature='io'))
+
+    def add_ddr_scenario(self, name, script, max_outstanding=32, lazy=False):
+        ddr = memory.dramsys.Dramsys(self, f'ddr_{name}')
+        ddr.add_properties({
+            'max-outstanding': max_outstanding,
+        })
+        if lazy:
+            ddr.set_sync_mode('lazy', period=10)
+        self.add_scenario(name, script, ddr)
+        return ddr
+
+
+
+class Chip(gvsoc.systree.Component):
+
+    def __init__(self, parent, name, parser, options):
+
+        super().__init__(parent, name, options=options)
+
+        clock = vp.clock_domain.Clock_domain(self, 'clock', frequency=1000000000)
+        testbench = Testbench(self, 'testbench')
+        clock.o_CLOCK    ( testbench.i_CLOCK     ())
+
+
+
+class Target(gvsoc.runner.Target):
+
+    def __init__(self, parser, options):
+        super(Target, self).__init__(parser, options,
+            model=Chip, description="DRAM access testbench")
@@ -0,0 +1,45 @@
+import vp.clock_domain
+import memory.dramsys
+import memory.dram_analytic
+import gvsoc.systree
+import gvsoc.runner
+import traffic_gen
+
+
+GAPY_TARGET = True
+
+class Testbench(gvsoc.systree.Component):
+
+    def __init__(self, parent, name):
+        super().__init__(parent, name)
+
+        # Both generators use the same seed so that the two DRAM models see exactly the same
+        # traffic and their latency distributions can be compared
+        gen_analytic = traffic_gen.TrafficGen(self, 'gen_analytic', seed=0x1234)
+        gen_dramsys = traffic_gen.TrafficGen(self, 'gen_dramsys', seed=0x1234)
+
+        analytic = memory.dram_analytic.DramAnalytic(self, 'analytic', dram_type='hbm2')
+        dramsys = memory.dramsys.Dramsys(self, 'dramsys')
+
+        gen_analytic.o_OUTPUT(gvsoc.systree.SlaveItf(analytic, 'input', signature='io'))
+        gen_dramsys.o_OUTPUT(gvsoc.systree.SlaveItf(dramsys, 'input', signature='io'))
+
+
+
+class Chip(gvsoc.systree.Component):
+
+    def __init__(self, parent, name, parser, options):
+
+        super().__init__(parent, name, options=options)
+
+        clock = vp.clock_domain.Clock_domain(self, 'clock', frequency=1000000000)
+        testbench = Testbench(self, 'testbench')
+        clock.o_CLOCK    ( testbench.i_CLOCK     ())
+
+
+
+class Target(gvsoc.runner.Target):
+
+    def __init__(self, parser, options):
+        super(Target, self).__init__(parser, options,
+            model=Chip, description="DRAM model calibration testbench")
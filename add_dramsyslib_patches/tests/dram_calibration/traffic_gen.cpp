@@ -0,0 +1,184 @@
+#include <vp/vp.hpp>
+#include <vp/itf/io.hpp>
+#include <stdio.h>
+#include <vector>
+#include <map>
+#include <algorithm>
+
+// Generates the same pseudo-random mix of sequential and random accesses for a given seed and
+// records the latency of each read, so that DRAM models can be compared on the same traffic.
+class TrafficGen : public vp::Component
+{
+public:
+    TrafficGen(vp::ComponentConf &config);
+
+private:
+    static void fsm_handler(vp::Block *__this, vp::ClockEvent *event);
+    static void grant(vp::Block *__this, vp::IoReq *req);
+    static void response(vp::Block *__this, vp::IoReq *req);
+
+    void reset(bool active) override;
+    uint32_t random();
+    void read_done(vp::IoReq *req);
+    void check_end();
+
+    vp::IoMaster output;
+    vp::ClockEvent fsm_event;
+
+    uint64_t seed;
+    int nb_reqs;
+    int req_size;
+    int outstanding;
+    uint64_t range;
+    int sequential_ratio;
+    int write_ratio;
+
+    int nb_sent;
+    int nb_done;
+    bool finished;
+    uint64_t next_addr;
+    vp::IoReq *denied_req;
+    std::vector<vp::IoReq *> free_reqs;
+    std::map<vp::IoReq *, int64_t> issue_time;
+    std::vector<int64_t> latencies;
+
+    static int nb_active;
+};
+
+int TrafficGen::nb_active = 0;
+
+TrafficGen::TrafficGen(vp::ComponentConf &config)
+    : vp::Component(config), fsm_event(this, &TrafficGen::fsm_handler)
+{
+    this->output.set_grant_meth(&TrafficGen::grant);
+    this->output.set_resp_meth(&TrafficGen::response);
+    this->new_master_port("output", &this->output);
+
+    this->seed = this->get_js_config()->get_child_int("seed");
+    this->nb_reqs = this->get_js_config()->get_child_int("nb-reqs");
+    this->req_size = this->get_js_config()->get_child_int("req-size");
+    this->outstanding = this->get_js_config()->get_child_int("outstanding");
+    this->range = this->get_js_config()->get_child_int("range");
+    this->sequential_ratio = this->get_js_config()->get_child_int("sequential-ratio");
+    this->write_ratio = this->get_js_config()->get_child_int("write-ratio");
+
+    for (int i = 0; i < this->outstanding; i++)
+    {
+        vp::IoReq *req = new vp::IoReq();
+        req->set_data(new uint8_t[this->req_size]);
+        this->free_reqs.push_back(req);
+    }
+
+    nb_active++;
+}
+
+void TrafficGen::reset(bool active)
+{
+    if (!active)
+    {
+        this->nb_sent = 0;
+        this->nb_done = 0;
+        this->finished = false;
+        this->next_addr = 0;
+        this->denied_req = NULL;
+        this->fsm_event.enqueue();
+    }
+}
+
+uint32_t TrafficGen::random()
+{
+    this->seed = this->seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return this->seed >> 33;
+}
+
+void TrafficGen::fsm_handler(vp::Block *__this, vp::ClockEvent *event)
+{
+    TrafficGen *_this = (TrafficGen *)__this;
+
+    while (_this->denied_req == NULL && _this->free_reqs.size() != 0 && _this->nb_sent < _this->nb_reqs)
+    {
+        vp::IoReq *req = _this->free_reqs.back();
+        _this->free_reqs.pop_back();
+
+        if ((int)(_this->random() % 100) >= _this->sequential_ratio)
+        {
+            _this->next_addr = (_this->random() % (_this->range / _this->req_size)) * _this->req_size;
+        }
+
+        req->init();
+        req->set_addr(_this->next_addr);
+        req->set_size(_this->req_size);
+        req->set_is_write((int)(_this->random() % 100) < _this->write_ratio);
+        if (!req->get_is_write()) _this->issue_time[req] = _this->time.get_time();
+        _this->next_addr = (_this->next_addr + _this->req_size) % _this->range;
+        _this->nb_sent++;
+
+        vp::IoReqStatus status = _this->output.req(req);
+        if (status == vp::IO_REQ_OK)
+        {
+            _this->issue_time.erase(req);
+            _this->nb_done++;
+            _this->free_reqs.push_back(req);
+        }
+        else if (status == vp::IO_REQ_DENIED)
+        {
+            _this->denied_req = req;
+        }
+    }
+
+    if (_this->denied_req == NULL && _this->free_reqs.size() != 0 && _this->nb_sent < _this->nb_reqs)
+    {
+        _this->fsm_event.enqueue();
+    }
+
+    _this->check_end();
+}
+
+void TrafficGen::grant(vp::Block *__this, vp::IoReq *req)
+{
+    TrafficGen *_this = (TrafficGen *)__this;
+    _this->denied_req = NULL;
+    if (!_this->fsm_event.is_enqueued()) _this->fsm_event.enqueue();
+}
+
+void TrafficGen::response(vp::Block *__this, vp::IoReq *req)
+{
+    TrafficGen *_this = (TrafficGen *)__this;
+
+    if (!req->get_is_write())
+    {
+        auto it = _this->issue_time.find(req);
+        _this->latencies.push_back(_this->time.get_time() - it->second);
+        _this->issue_time.erase(it);
+    }
+    _this->nb_done++;
+    _this->free_reqs.push_back(req);
+
+    if (!_this->fsm_event.is_enqueued()) _this->fsm_event.enqueue();
+}
+
+void TrafficGen::check_end()
+{
+    if (this->finished || this->nb_done != this->nb_reqs) return;
+    this->finished = true;
+
+    std::sort(this->latencies.begin(), this->latencies.end());
+    int64_t sum = 0;
+    for (int64_t latency : this->latencies) sum += latency;
+    int nb = this->latencies.size();
+
+    printf("latency %s: mean %.1f ns p50 %.1f ns p90 %.1f ns\n", this->get_path().c_str(),
+        nb ? (double)sum / nb / 1000 : 0.0,
+        nb ? (double)this->latencies[nb / 2] / 1000 : 0.0,
+        nb ? (double)this->latencies[nb * 9 / 10] / 1000 : 0.0);
+
+    if (--nb_active == 0)
+    {
+        this->time.get_engine()->quit(0);
+    }
+}
+
+extern "C" vp::Component *gv_new(vp::ComponentConf &config)
+{
+    return new TrafficGen(config);
+}
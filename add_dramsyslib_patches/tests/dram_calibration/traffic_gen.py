@@ -0,0 +1,23 @@
+import gvsoc.systree
+
+class TrafficGen(gvsoc.systree.Component):
+    def __init__(self, parent: gvsoc.systree.Component, name: str, seed: int, nb_reqs: int=4000,
+            req_size: int=64, outstanding: int=8, addr_range: int=0x1000000, sequential_ratio: int=50,
+            write_ratio: int=30):
+
+        super().__init__(parent, name)
+
+        self.add_sources(['traffic_gen.cpp'])
+
+        self.add_properties({
+            'seed': seed,
+            'nb-reqs': nb_reqs,
+            'req-size': req_size,
+            'outstanding': outstanding,
+            'range': addr_range,
+            'sequential-ratio': sequential_ratio,
+            'write-ratio': write_ratio,
+        })
+
+    def o_OUTPUT(self, itf: gvsoc.systree.SlaveItf):
+        self.itf_bind('output', itf, signature='io')
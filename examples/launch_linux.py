@@ -3,8 +3,14 @@
 import pexpect
 import os
 import sys
+import time
 
 
+# The host time of the boot is reported so that simulator speedups can be measured on it
+start = time.time()
 run = pexpect.spawn("gvsoc --target=rv64_untimed --binary ./spike_fw_payload.elf  run", encoding='utf-8', logfile=sys.stdout, env=os.environ)
-match = run.expect(['NFS preparation skipped, OK'], timeout=None)
-match = run.expect(['#'], timeout=None)
\ No newline at end of file
+for prompt in ['NFS preparation skipped, OK', '#']:
+    if run.expect([prompt, pexpect.EOF], timeout=None) != 0:
+        print(f'\nLinux boot: gvsoc exited before "{prompt}"')
+        sys.exit(1)
+print(f'\nLinux boot: {time.time() - start:.1f} s host time')